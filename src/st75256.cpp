@@ -34,51 +34,59 @@ int st75256::setup(TwoWire& i2c_library, const uint8_t i2c_address, const int pi
     m_i2c_address = i2c_address;
     m_buffer = buffer;
 
-    /* Perform reset */
-    pinMode(pin_res, OUTPUT);
-    digitalWrite(pin_res, LOW);
-    delay(2);
-    digitalWrite(pin_res, HIGH);
-    delay(2);
+    /* Reset and configure driver */
+    return m_init(pin_res);
+}
 
-    /* Configure driver */
-    uint16_t Contrast = 200;
-    int res = 0;
-    res |= command_send(COMMAND_EXTENSION_1);
-    res |= command_send(COMMAND_SLEEP_OUT);
-    delay(50);
-    res |= command_send(0x31);  // Extension Command 2
-    res |= command_send(0x32);  // Analog Circuit Set
-    res |= data_send(0x00);
-    res |= data_send(0x01);
-    res |= data_send(0x03);
-    res |= command_send(0x51);  // Booster Level x10
-    res |= data_send(0xFA);     // 8X
-    res |= command_send(0x30);  // Extension Command 1
-    res |= command_send(0x20);  // Power Control
-    res |= data_send(0x0b);     // VB ON ; VR,VF ON
-    res |= command_send(0x81);  // Vop Control
-    res |= data_send(Contrast & 0x3F);
-    res |= data_send((Contrast >> 6) & 0x07);
-    res |= command_send(0x0C);  // Data Format Select     DO=1; LSB on top
-    res |= command_send(0xf0);  // Display Mode
-    res |= data_send(0x10);     // Monochrome Mode
-    res |= command_send(0xCA);  // Display Control
-    res |= data_send(0);
-    res |= data_send(95);  // duty
-    res |= data_send(0x00);
-    res |= command_send(0xBC);  // ata Scan Direction
-    res |= data_send(0x00);     // MY=0
-    res |= command_send(0xaf);  // Display On
-    if (res != 0) {
-        return -EIO;
+/**
+ * @brief Configures the driver for I2C communication without local buffer
+ *
+ * Sets up the ST75256 to communicate over I2C without a local copy of the
+ * GDRAM. Pixels are modified by reading back the GDRAM, and the modified
+ * bytes are kept in a small write-back cache until display() is called.
+ * This function also performs hardware reset and initializes the display
+ * with default settings.
+ *
+ * @param[in] i2c_library Reference to the TwoWire I2C library instance (typically Wire)
+ * @param[in] i2c_address I2C address of the device (0x3C, 0x3D, 0x3E, or 0x3F)
+ * @param[in] pin_res GPIO pin number connected to the reset (RES) pin
+ * @param[in] cache Pointer to the lines that will be used to cache the GDRAM
+ * @param[in] cache_lines Number of lines pointed to by cache, at least 1
+ * @return 0 on success, or a negative error code otherwise
+ * @note Call this from the Arduino setup() function
+ * @note Make sure the I2C library has been initialized with Wire.begin()
+ */
+int st75256::setup(TwoWire& i2c_library, const uint8_t i2c_address, const int pin_res, struct cache_line* const cache, const size_t cache_lines) {
+
+    /* Ensure i2c address is valid */
+    if ((i2c_address != 0x3C) &&  //
+        (i2c_address != 0x3D) &&  //
+        (i2c_address != 0x3E) &&  //
+        (i2c_address != 0x3F)) {
+        return -EINVAL;
     }
 
-    /* */
-    delay(100);
+    /* Ensure cache is valid */
+    if (cache == NULL || cache_lines == 0) {
+        return -EINVAL;
+    }
 
-    /* Return success */
-    return 0;
+    /* Save parameters */
+    m_interface = INTERFACE_I2C_LIGHT;
+    m_i2c_library = &i2c_library;
+    m_i2c_address = i2c_address;
+    m_buffer = NULL;
+    m_cache = cache;
+    m_cache_lines = cache_lines;
+
+    /* Start with an empty cache */
+    for (size_t i = 0; i < m_cache_lines; i++) {
+        m_cache[i].valid = false;
+        m_cache[i].dirty = false;
+    }
+
+    /* Reset and configure driver */
+    return m_init(pin_res);
 }
 
 /**
@@ -151,6 +159,153 @@ void st75256::invertDisplay(bool i) {
     inverted_set(i);
 }
 
+/**
+ * @brief Restricts the display to a band of rows
+ *
+ * Enables the partial display mode of the controller, so that only the rows
+ * between line_start and line_end are scanned and the rest of the panel is
+ * left blank (see section 7.3.8). Rows are given in panel coordinates,
+ * regardless of the current rotation. The area is remembered so that wake()
+ * can restore it.
+ *
+ * @param[in] line_start First visible row
+ * @param[in] line_end Last visible row (inclusive)
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::partial_set(const size_t line_start, const size_t line_end) {
+
+    /* Ensure area is valid */
+    if (line_start > line_end || line_end >= m_active_height) {
+        return -EINVAL;
+    }
+
+    /* Enter partial mode */
+    int res;
+    res = command_send(COMMAND_EXTENSION_1);
+    if (res < 0) {
+        return res;
+    }
+    res = command_send(COMMAND_PARTIAL_IN);
+    if (res < 0) {
+        return res;
+    }
+    res = data_send(line_start);
+    if (res < 0) {
+        return res;
+    }
+    res = data_send(line_end);
+    if (res < 0) {
+        return res;
+    }
+
+    /* Remember area */
+    m_partial_enabled = true;
+    m_partial_start = line_start;
+    m_partial_end = line_end;
+
+    /* Return success */
+    return 0;
+}
+
+/**
+ * @brief Exits partial display mode
+ *
+ * Makes the whole panel visible again after a call to partial_set().
+ *
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::partial_disable(void) {
+    int res;
+    res = command_send(COMMAND_EXTENSION_1);
+    if (res < 0) {
+        return res;
+    }
+    res = command_send(COMMAND_PARTIAL_OUT);
+    if (res < 0) {
+        return res;
+    }
+    m_partial_enabled = false;
+    return 0;
+}
+
+/**
+ * @brief Puts the display to sleep
+ *
+ * Turns the display off and enters the sleep in mode, which stops the DC/DC
+ * converter, the oscillator and the panel scanning (see section 9.2.6). The
+ * GDRAM contents and the configuration are retained. For unbuffered interfaces,
+ * pending cache lines are written back first.
+ *
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::sleep(void) {
+    int res;
+
+    /* Nothing to do if already asleep */
+    if (m_sleeping) {
+        return 0;
+    }
+
+    /* Make sure gdram is up to date */
+    if (m_interface == INTERFACE_I2C_LIGHT) {
+        res = m_cache_flush();
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    /* Enter sleep */
+    res = 0;
+    res |= command_send(COMMAND_EXTENSION_1);
+    res |= command_send(COMMAND_DISPLAY_OFF);
+    res |= command_send(COMMAND_SLEEP_IN);
+    if (res != 0) {
+        return -EIO;
+    }
+    m_sleeping = true;
+
+    /* Return success */
+    return 0;
+}
+
+/**
+ * @brief Wakes the display up from sleep
+ *
+ * Exits the sleep in mode, waits for the DC/DC converter to start, restores
+ * the partial display area if one was set and turns the display back on. No
+ * hardware reset or framebuffer transfer is needed, as the GDRAM is retained.
+ *
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::wake(void) {
+
+    /* Nothing to do if already awake */
+    if (!m_sleeping) {
+        return 0;
+    }
+
+    /* Exit sleep */
+    int res = 0;
+    res |= command_send(COMMAND_EXTENSION_1);
+    res |= command_send(COMMAND_SLEEP_OUT);
+    delay(50);
+
+    /* Restore shadowed settings */
+    if (m_partial_enabled) {
+        res |= command_send(COMMAND_PARTIAL_IN);
+        res |= data_send(m_partial_start);
+        res |= data_send(m_partial_end);
+    }
+    res |= command_send(COMMAND_DISPLAY_ON);
+    if (res != 0) {
+        return -EIO;
+    }
+    m_sleeping = false;
+
+    /* Return success */
+    return 0;
+}
+
 /**
  * @brief Clears the entire display
  *
@@ -164,13 +319,25 @@ int st75256::clear(void) {
     switch (m_interface) {
 
         case INTERFACE_I2C_LIGHT: {  // For unbuffered interface, clear gdram directly
-            for (size_t i = 0; i < (m_gdram_height + 7) / 8; i++) {
-                // command_send(COMMAND_PAGE_ADDRESS + i);
-                // command_send(COMMAND_COLUMN_ADDRESS_L | (2 & 0x0F));
-                // command_send(COMMAND_COLUMN_ADDRESS_H | (2 >> 4));
-                // for (size_t j = 0; j < m_active_width; j++) {
-                //     data_send(0x00);
-                // }
+
+            /* Drop cached lines, they would otherwise overwrite the cleared gdram */
+            for (size_t i = 0; i < m_cache_lines; i++) {
+                m_cache[i].valid = false;
+                m_cache[i].dirty = false;
+            }
+
+            /* Fill the active area with zeroes */
+            uint8_t zeroes[cache_line::width] = {0};
+            int res = 0;
+            res |= m_window_set(0, m_active_width - 1, 0, ((m_active_height + 7) / 8) - 1);
+            res |= command_send(COMMAND_DATA_WRITE);
+            for (size_t i = 0; i < m_active_width * ((m_active_height + 7) / 8); i += cache_line::width) {
+                size_t length = m_active_width * ((m_active_height + 7) / 8) - i;
+                if (length > cache_line::width) length = cache_line::width;
+                res |= data_send(zeroes, length);
+            }
+            if (res != 0) {
+                return -EIO;
             }
             return 0;
         }
@@ -221,32 +388,17 @@ int st75256::pixel_set(const size_t x, const size_t y, const uint16_t color) {
         }
 
         case INTERFACE_I2C_LIGHT: {
-            // TODO Maybe insert a dummy read (see section 7.2)
-            // res = 0;
-            // m_i2c_library->beginTransmission(m_i2c_address);
-            // m_i2c_library->write(0x80);  // CO = 1, DC = 0
-            // m_i2c_library->write(COMMAND_PAGE_ADDRESS + (y_panel / 8));
-            // m_i2c_library->write(0x80);  // CO = 1, DC = 0
-            // m_i2c_library->write(COMMAND_COLUMN_ADDRESS_L | ((x_panel + 2) & 0x0F));
-            // m_i2c_library->write(0x80);  // CO = 1, DC = 0
-            // m_i2c_library->write(COMMAND_COLUMN_ADDRESS_H | ((x_panel + 2) >> 4));
-            // m_i2c_library->write(0x80);  // CO = 1, DC = 0
-            // m_i2c_library->write(COMMAND_READWRITEMODIFY_BEGIN);
-            // m_i2c_library->write(0x40);  // CO = 0, DC = 1
-            // m_i2c_library->endTransmission(false);
-            // m_i2c_library->requestFrom(m_i2c_address, 2, true);
-            // m_i2c_library->read();                 // Dummy read
-            // uint8_t data = m_i2c_library->read();  // Gdram data
-            // m_i2c_library->beginTransmission(m_i2c_address);
-            // m_i2c_library->write(0xC0);  // CO = 1, DC = 1
-            // if (color) {
-            //     m_i2c_library->write((1 << (y_panel % 8)) | data);
-            // } else {
-            //     m_i2c_library->write(~(1 << (y_panel % 8)) & data);
-            // }
-            // m_i2c_library->write(0x00);  // CO = 0, DC = 0
-            // m_i2c_library->write(COMMAND_READWRITEMODIFY_END);
-            // m_i2c_library->endTransmission(true);
+            struct cache_line* line;
+            res = m_cache_fetch(x_panel, y_panel / 8, line);
+            if (res < 0) {
+                return res;
+            }
+            if (color) {
+                line->data[x_panel - line->column] |= (1 << (y_panel % 8));
+            } else {
+                line->data[x_panel - line->column] &= ~(1 << (y_panel % 8));
+            }
+            line->dirty = true;
             break;
         }
 
@@ -277,7 +429,8 @@ void st75256::drawPixel(int16_t x, int16_t y, uint16_t color) {
  *
  * Sends the contents of the local buffer to the display GDRAM. This function
  * should be called after making changes to the buffer to update the visible display.
- * For unbuffered interfaces, this function does nothing.
+ * For unbuffered interfaces, this function writes back the modified lines of the cache.
+ * Refresh requests pending in the frame pacing scheduler are satisfied by this flush.
  *
  * @return 0 on success, or a negative error code otherwise
  */
@@ -286,37 +439,134 @@ int st75256::display(void) {
     switch (m_interface) {
 
         case INTERFACE_I2C_LIGHT: {
-            return 0;
+            res = m_cache_flush();
+            break;
         }
 
         case INTERFACE_I2C_BUFFERED: {
-
-            command_send(0xf0);  // Display Mode
-            data_send(0x10);     // Monochrome Mode
-
-            command_send(0x15);
-            data_send(0);
-            data_send(191);  // TODO
-
-            command_send(0x75);
-            data_send(0);
-            data_send(11);  // TODO
-
-            command_send(0x5c);
-
+            res = 0;
+            res |= command_send(0xf0);  // Display Mode
+            res |= data_send(0x10);     // Monochrome Mode
+            res |= m_window_set(0, m_active_width - 1, 0, ((m_active_height + 7) / 8) - 1);
+            res |= command_send(COMMAND_DATA_WRITE);
             for (size_t i = 0, p = 0; i < (m_active_height + 7) / 8; i++) {
                 for (size_t j = 0; j < m_active_width; j++) {
-                    data_send(m_buffer[p++]);
+                    res |= data_send(m_buffer[p++]);
                 }
             }
-
-            return 0;
+            if (res != 0) {
+                res = -EIO;
+            }
+            break;
         }
 
         default: {
             return -EINVAL;
         }
     }
+    if (res < 0) {
+        return res;
+    }
+
+    /* Pending refresh requests are satisfied by this flush */
+    if (m_refresh_pending > 0) {
+        m_refresh_coalesced += m_refresh_pending - 1;
+        m_refresh_pending = 0;
+    }
+
+    /* Return success */
+    return 0;
+}
+
+/**
+ * @brief Configures the frame pacing of request_refresh() and service()
+ *
+ * Sets the minimum time between two flushes performed by the scheduler. An
+ * optional maximum latency makes request_refresh() flush by itself when a
+ * pending refresh has been waiting for too long. The maximum latency can not
+ * be shorter than the interval, so it is met whenever flushes succeed. Flushes
+ * never happen more than once per interval, so that the bus load stays capped
+ * even when retrying after a failed flush.
+ *
+ * @param[in] interval_ms Minimum time between two flushes in milliseconds, 0 to disable pacing
+ * @param[in] latency_max_ms Maximum time a refresh may stay pending in milliseconds, 0 to disable
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::refresh_interval_set(const uint32_t interval_ms, const uint32_t latency_max_ms) {
+
+    /* Ensure parameters are valid */
+    if (latency_max_ms != 0 && latency_max_ms < interval_ms) {
+        return -EINVAL;
+    }
+
+    /* Save parameters */
+    m_refresh_interval = interval_ms;
+    m_refresh_latency_max = latency_max_ms;
+
+    /* Allow the next flush right away */
+    m_refresh_last = millis() - interval_ms;
+
+    /* Return success */
+    return 0;
+}
+
+/**
+ * @brief Marks the display as needing a refresh
+ *
+ * Does not send anything to the display, unless a maximum latency has been
+ * configured, the oldest pending request has exceeded it and the frame interval
+ * has elapsed. The actual flush is otherwise performed by service().
+ *
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::request_refresh(void) {
+    uint32_t now = millis();
+
+    /* Mark as stale */
+    if (m_refresh_pending == 0) {
+        m_refresh_first = now;
+    }
+    m_refresh_pending++;
+    m_refresh_requests++;
+
+    /* Enforce maximum latency */
+    if (m_refresh_latency_max != 0 && (now - m_refresh_first) >= m_refresh_latency_max) {
+        return m_refresh_handle(now);
+    }
+
+    /* Return success */
+    return 0;
+}
+
+/**
+ * @brief Performs a pending refresh if the frame interval has elapsed
+ *
+ * Calls display() at most once per frame interval, merging all the changes
+ * requested since the previous flush.
+ *
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::service(void) {
+    return m_refresh_handle(millis());
+}
+
+/**
+ * @brief Retrieves frame pacing statistics
+ *
+ * @param[out] requests Number of calls to request_refresh()
+ * @param[out] coalesced Number of requests merged into another flush
+ */
+void st75256::refresh_stats_get(uint32_t& requests, uint32_t& coalesced) const {
+    requests = m_refresh_requests;
+    coalesced = m_refresh_coalesced;
+}
+
+/**
+ * @brief Resets frame pacing statistics
+ */
+void st75256::refresh_stats_reset(void) {
+    m_refresh_requests = 0;
+    m_refresh_coalesced = 0;
 }
 
 /**
@@ -422,6 +672,49 @@ int st75256::data_send(uint8_t* const data, const size_t length) {
     }
 }
 
+/**
+ * @brief Receives multiple data bytes from the display
+ *
+ * Low-level function to read multiple consecutive data bytes from the display GDRAM.
+ * The first byte read after an address set is a dummy byte (see section 7.2), it is
+ * up to the caller to discard it. The function handles I2C buffer size limitations
+ * by splitting large transfers into multiple I2C transactions if necessary.
+ *
+ * @param[out] data Pointer to the array that will receive the data
+ * @param[in] length Number of bytes to receive
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::data_receive(uint8_t* const data, const size_t length) {
+    int res;
+    switch (m_interface) {
+
+        case INTERFACE_I2C_LIGHT:
+        case INTERFACE_I2C_BUFFERED: {
+            for (size_t i = 0; i < length;) {
+                m_i2c_library->beginTransmission(m_i2c_address);
+                m_i2c_library->write(0x40);  // CO = 0, A0 = 1
+                res = m_i2c_library->endTransmission(false);
+                if (res != 0) {
+                    return -EIO;
+                }
+                size_t chunk = length - i;
+                if (chunk > 32) chunk = 32;
+                if (m_i2c_library->requestFrom(m_i2c_address, (uint8_t)chunk, (uint8_t)true) != chunk) {
+                    return -EIO;
+                }
+                while (chunk--) {
+                    data[i++] = m_i2c_library->read();
+                }
+            }
+            return 0;
+        }
+
+        default: {
+            return -EINVAL;
+        }
+    }
+}
+
 /**
  * @brief Handles coordinate rotation and validation
  *
@@ -468,3 +761,216 @@ int st75256::m_rotation_handle(const size_t x, const size_t y, size_t& x_panel,
     }
     return 0;
 }
+
+/**
+ * @brief Resets the controller and sends the initialization sequence
+ *
+ * Shared by all setup() variants once the interface has been saved.
+ *
+ * @param[in] pin_res GPIO pin number connected to the reset (RES) pin
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::m_init(const int pin_res) {
+
+    /* Forget settings cleared by the reset */
+    m_partial_enabled = false;
+    m_sleeping = false;
+
+    /* Perform reset */
+    pinMode(pin_res, OUTPUT);
+    digitalWrite(pin_res, LOW);
+    delay(2);
+    digitalWrite(pin_res, HIGH);
+    delay(2);
+
+    /* Configure driver */
+    uint16_t Contrast = 200;
+    int res = 0;
+    res |= command_send(COMMAND_EXTENSION_1);
+    res |= command_send(COMMAND_SLEEP_OUT);
+    delay(50);
+    res |= command_send(0x31);  // Extension Command 2
+    res |= command_send(0x32);  // Analog Circuit Set
+    res |= data_send(0x00);
+    res |= data_send(0x01);
+    res |= data_send(0x03);
+    res |= command_send(0x51);  // Booster Level x10
+    res |= data_send(0xFA);     // 8X
+    res |= command_send(0x30);  // Extension Command 1
+    res |= command_send(0x20);  // Power Control
+    res |= data_send(0x0b);     // VB ON ; VR,VF ON
+    res |= command_send(0x81);  // Vop Control
+    res |= data_send(Contrast & 0x3F);
+    res |= data_send((Contrast >> 6) & 0x07);
+    res |= command_send(0x0C);  // Data Format Select     DO=1; LSB on top
+    res |= command_send(0xf0);  // Display Mode
+    res |= data_send(0x10);     // Monochrome Mode
+    res |= command_send(0xCA);  // Display Control
+    res |= data_send(0);
+    res |= data_send(95);  // duty
+    res |= data_send(0x00);
+    res |= command_send(0xBC);  // ata Scan Direction
+    res |= data_send(0x00);     // MY=0
+    res |= command_send(0xaf);  // Display On
+    if (res != 0) {
+        return -EIO;
+    }
+
+    /* */
+    delay(100);
+
+    /* Return success */
+    return 0;
+}
+
+/**
+ * @brief Sets the gdram window used by subsequent data reads and writes
+ *
+ * Data reads and writes start at the top left corner of the window and the
+ * address wraps to the next page when the last column of the window is reached.
+ *
+ * @param[in] column_start First column of the window
+ * @param[in] column_end Last column of the window (inclusive)
+ * @param[in] page_start First page of the window
+ * @param[in] page_end Last page of the window (inclusive)
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::m_window_set(const uint8_t column_start, const uint8_t column_end, const uint8_t page_start, const uint8_t page_end) {
+    int res = 0;
+    res |= command_send(COMMAND_COLUMN_ADDRESS_SET);
+    res |= data_send(column_start);
+    res |= data_send(column_end);
+    res |= command_send(COMMAND_PAGE_ADDRESS_SET);
+    res |= data_send(page_start);
+    res |= data_send(page_end);
+    if (res != 0) {
+        return -EIO;
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns the cache line holding the given gdram byte
+ *
+ * Lines cover cache_line::width aligned columns of a single page. On a
+ * miss, the least recently used line is written back if it has been modified,
+ * then refilled with a single windowed read of the gdram.
+ *
+ * @param[in] column Gdram column of the byte
+ * @param[in] page Gdram page of the byte
+ * @param[out] line Output parameter for the cache line
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::m_cache_fetch(const size_t column, const size_t page, struct cache_line*& line) {
+    int res;
+
+    /* Look for the line, and for the victim in case of a miss */
+    size_t column_start = column - (column % cache_line::width);
+    struct cache_line* victim = &m_cache[0];
+    for (size_t i = 0; i < m_cache_lines; i++) {
+        if (m_cache[i].valid && m_cache[i].page == page && m_cache[i].column == column_start) {
+            m_cache[i].stamp = ++m_cache_clock;
+            line = &m_cache[i];
+            return 0;
+        }
+        if (!m_cache[i].valid) {
+            victim = &m_cache[i];
+        } else if (victim->valid && m_cache[i].stamp < victim->stamp) {
+            victim = &m_cache[i];
+        }
+    }
+
+    /* Write back the victim */
+    res = m_cache_line_flush(*victim);
+    if (res < 0) {
+        return res;
+    }
+    victim->valid = false;
+
+    /* Refill it from gdram */
+    size_t length = m_active_width - column_start;
+    if (length > cache_line::width) length = cache_line::width;
+    uint8_t data[cache_line::width + 1];
+    res = 0;
+    res |= m_window_set(column_start, column_start + length - 1, page, page);
+    res |= command_send(COMMAND_DATA_READ);
+    res |= data_receive(data, length + 1);  // Leading dummy byte, in the same transaction (see section 7.2)
+    if (res != 0) {
+        return -EIO;
+    }
+    memcpy(victim->data, &data[1], length);
+    victim->valid = true;
+    victim->dirty = false;
+    victim->page = page;
+    victim->column = column_start;
+    victim->length = length;
+    victim->stamp = ++m_cache_clock;
+
+    /* Return success */
+    line = victim;
+    return 0;
+}
+
+/**
+ * @brief Writes back a cache line to the gdram if it has been modified
+ *
+ * The whole line is sent in a single windowed write, so that consecutive pixels
+ * modified in the same page only cost one transfer.
+ *
+ * @param[in] line Cache line to write back
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::m_cache_line_flush(struct cache_line& line) {
+    if (!line.valid || !line.dirty) {
+        return 0;
+    }
+    int res = 0;
+    res |= m_window_set(line.column, line.column + line.length - 1, line.page, line.page);
+    res |= command_send(COMMAND_DATA_WRITE);
+    res |= data_send(line.data, line.length);
+    if (res != 0) {
+        return -EIO;
+    }
+    line.dirty = false;
+    return 0;
+}
+
+/**
+ * @brief Writes back all the modified cache lines to the gdram
+ *
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::m_cache_flush(void) {
+    for (size_t i = 0; i < m_cache_lines; i++) {
+        int res = m_cache_line_flush(m_cache[i]);
+        if (res < 0) {
+            return res;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Flushes the display if a refresh is pending and allowed
+ *
+ * A flush is allowed once the frame interval has elapsed since the previous
+ * one, whether it is triggered by service() or by the maximum latency. When
+ * the flush fails, the refresh stays pending for the next allowed slot.
+ *
+ * @param[in] now Current time in milliseconds
+ * @return 0 on success, or a negative error code otherwise
+ */
+int st75256::m_refresh_handle(const uint32_t now) {
+
+    /* Nothing to do if up to date or too early */
+    if (m_refresh_pending == 0) {
+        return 0;
+    }
+    if ((now - m_refresh_last) < m_refresh_interval) {
+        return 0;
+    }
+
+    /* Flush, consuming the slot even on failure so that retries stay paced */
+    m_refresh_last = now;
+    return display();
+}
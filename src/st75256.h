@@ -26,6 +26,23 @@
 class st75256 : public Adafruit_GFX {
 
    public:
+    /**
+     * @brief Line of the gdram cache used by the unbuffered interface
+     *
+     * Holds a run of consecutive columns of a single gdram page. The storage is
+     * provided by the caller to setup(), so that buffered instances do not pay for it.
+     */
+    struct cache_line {
+        static const uint8_t width = 16;  //!< Number of consecutive columns held by a line
+        bool valid;                       //!< Line holds a copy of the gdram
+        bool dirty;                       //!< Line has been modified since it was read
+        uint8_t page;                     //!< Gdram page of the line
+        uint8_t column;                   //!< Gdram column of the first byte of the line
+        uint8_t length;                   //!< Number of valid bytes in the line
+        uint32_t stamp;                   //!< Last use, for least recently used eviction
+        uint8_t data[width];              //!< Copy of the gdram bytes
+    };
+
     //!@{
     //! Initialization and setup
     /**
@@ -57,7 +74,24 @@ class st75256 : public Adafruit_GFX {
      * @note Make sure the I2C library has been initialized with Wire.begin()
      */
     int setup(TwoWire& i2c_library, const uint8_t i2c_address, const int pin_res, uint8_t* const buffer);
-    // int setup(TwoWire& i2c_library, const uint8_t i2c_address, const int pin_res);
+
+    /**
+     * @brief Configures the driver for I2C communication without local buffer
+     *
+     * Sets up the ST75256 to communicate over I2C without a local copy of the
+     * GDRAM. Pixels are modified by reading back the GDRAM, and the modified
+     * bytes are kept in a small write-back cache until display() is called.
+     *
+     * @param[in] i2c_library Reference to the TwoWire I2C library instance (typically Wire)
+     * @param[in] i2c_address I2C address of the device (0x3C, 0x3D, 0x3E, or 0x3F)
+     * @param[in] pin_res GPIO pin number connected to the reset (RES) pin
+     * @param[in] cache Pointer to the lines that will be used to cache the GDRAM
+     * @param[in] cache_lines Number of lines pointed to by cache, at least 1
+     * @return 0 on success, or a negative error code otherwise
+     * @note Call this from the Arduino setup() function
+     * @note Make sure the I2C library has been initialized with Wire.begin()
+     */
+    int setup(TwoWire& i2c_library, const uint8_t i2c_address, const int pin_res, struct cache_line* const cache, const size_t cache_lines);
     //!@}
 
     //!@{
@@ -107,6 +141,55 @@ class st75256 : public Adafruit_GFX {
      * @param[in] i true to invert display, false for normal display
      */
     void invertDisplay(bool i);
+
+    /**
+     * @brief Restricts the display to a band of rows
+     *
+     * Enables the partial display mode of the controller, so that only the rows
+     * between line_start and line_end are scanned and the rest of the panel is
+     * left blank. This reduces power consumption when only part of the screen,
+     * like a status bar, needs to be visible. Rows are given in panel coordinates,
+     * regardless of the current rotation.
+     *
+     * @param[in] line_start First visible row
+     * @param[in] line_end Last visible row (inclusive)
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int partial_set(const size_t line_start, const size_t line_end);
+
+    /**
+     * @brief Exits partial display mode
+     *
+     * Makes the whole panel visible again after a call to partial_set().
+     *
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int partial_disable(void);
+    //!@}
+
+    //!@{
+    //! Power management
+    /**
+     * @brief Puts the display to sleep
+     *
+     * Turns the display off and enters the sleep in mode, which stops the DC/DC
+     * converter, the oscillator and the panel scanning. The GDRAM contents and
+     * the configuration are retained.
+     *
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int sleep(void);
+
+    /**
+     * @brief Wakes the display up from sleep
+     *
+     * Exits the sleep in mode and turns the display back on, restoring the partial
+     * display area if one was set. No hardware reset or framebuffer transfer is
+     * needed, the previous image is shown again as is.
+     *
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int wake(void);
     //!@}
 
     //!@{
@@ -155,13 +238,67 @@ class st75256 : public Adafruit_GFX {
      *
      * Sends the contents of the local buffer to the display GDRAM. This function
      * should be called after making changes to the buffer to update the visible display.
-     * For unbuffered interfaces, this function does nothing.
+     * For unbuffered interfaces, this function writes back the modified lines of the cache.
+     * Refresh requests pending in the frame pacing scheduler are satisfied by this flush.
      *
      * @return 0 on success, or a negative error code otherwise
      */
     int display(void);
     //!@}
 
+    //!@{
+    //! Frame pacing
+    /**
+     * @brief Configures the frame pacing of request_refresh() and service()
+     *
+     * Sets the minimum time between two flushes performed by the scheduler. An
+     * optional maximum latency makes request_refresh() flush by itself when a
+     * pending refresh has been waiting for too long, for example because service()
+     * is not called often enough. Flushes still never happen more than once per
+     * interval, so after a failed flush the next attempt waits for the next slot.
+     *
+     * @param[in] interval_ms Minimum time between two flushes in milliseconds, 0 to disable pacing
+     * @param[in] latency_max_ms Maximum time a refresh may stay pending in milliseconds, 0 to disable
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int refresh_interval_set(const uint32_t interval_ms, const uint32_t latency_max_ms = 0);
+
+    /**
+     * @brief Marks the display as needing a refresh
+     *
+     * Does not send anything to the display, unless a maximum latency has been
+     * configured, has been exceeded and the frame interval has elapsed. The actual
+     * flush is otherwise performed by service().
+     *
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int request_refresh(void);
+
+    /**
+     * @brief Performs a pending refresh if the frame interval has elapsed
+     *
+     * Calls display() at most once per frame interval, merging all the changes
+     * requested since the previous flush. Call this regularly, typically from
+     * the Arduino loop() function.
+     *
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int service(void);
+
+    /**
+     * @brief Retrieves frame pacing statistics
+     *
+     * @param[out] requests Number of calls to request_refresh()
+     * @param[out] coalesced Number of requests merged into another flush
+     */
+    void refresh_stats_get(uint32_t& requests, uint32_t& coalesced) const;
+
+    /**
+     * @brief Resets frame pacing statistics
+     */
+    void refresh_stats_reset(void);
+    //!@}
+
     /* Commands
      * Full list at section 9.1 page 59 */
     enum command {
@@ -173,6 +310,12 @@ class st75256 : public Adafruit_GFX {
         COMMAND_EXTENSION_4 = 0x39,
 
         /* Commandset for extension 1 (starts at section 9.2.2 page 63) */
+        COMMAND_COLUMN_ADDRESS_SET = 0x15,
+        COMMAND_DATA_WRITE = 0x5C,
+        COMMAND_DATA_READ = 0x5D,
+        COMMAND_PAGE_ADDRESS_SET = 0x75,
+        COMMAND_PARTIAL_IN = 0xA8,
+        COMMAND_PARTIAL_OUT = 0xA9,
         COMMAND_DISPLAY_OFF = 0xAE,
         COMMAND_DISPLAY_ON = 0xAF,
         COMMAND_SCAN_DIRECTION = 0xBC,
@@ -217,6 +360,18 @@ class st75256 : public Adafruit_GFX {
      * @return 0 on success, or a negative error code otherwise
      */
     int data_send(uint8_t* const data, const size_t length);
+
+    /**
+     * @brief Receives multiple data bytes from the display
+     *
+     * Low-level function to read multiple consecutive data bytes from the display GDRAM.
+     * The first byte read after an address set is a dummy byte (see section 7.2).
+     *
+     * @param[out] data Pointer to the array that will receive the data
+     * @param[in] length Number of bytes to receive
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int data_receive(uint8_t* const data, const size_t length);
     //!@}
 
    protected:
@@ -226,6 +381,16 @@ class st75256 : public Adafruit_GFX {
     TwoWire* m_i2c_library = NULL;                           //!< Pointer to I2C library instance
     uint8_t m_i2c_address = 0;                               //!< Device I2C address
     uint8_t* m_buffer = NULL;                                //!< Pointer to local display buffer
+    bool m_partial_enabled = false;                          //!< Partial display mode is active
+    uint8_t m_partial_start = 0, m_partial_end = 0;          //!< Rows of the partial display area
+    bool m_sleeping = false;                                 //!< Display is in sleep in mode
+    uint32_t m_refresh_interval = 0;                         //!< Minimum time between two scheduled flushes (ms)
+    uint32_t m_refresh_latency_max = 0;                      //!< Maximum time a refresh may stay pending (ms)
+    uint32_t m_refresh_last = 0;                             //!< Time of the last scheduled flush (ms)
+    uint32_t m_refresh_first = 0;                            //!< Time of the oldest pending request (ms)
+    uint32_t m_refresh_pending = 0;                          //!< Number of requests since the last flush
+    uint32_t m_refresh_requests = 0;                         //!< Statistics: number of requests
+    uint32_t m_refresh_coalesced = 0;                        //!< Statistics: number of requests merged into another flush
 
     enum interface {
         INTERFACE_NONE,              //!< No interface configured
@@ -233,6 +398,65 @@ class st75256 : public Adafruit_GFX {
         INTERFACE_I2C_BUFFERED,      //!< I2C interface with local buffer
     } m_interface = INTERFACE_NONE;  //!< Current communication interface
 
+    struct cache_line* m_cache = NULL;           //!< Write-back cache of the gdram for unbuffered interfaces
+    size_t m_cache_lines = 0;                    //!< Number of lines in the cache
+    uint32_t m_cache_clock = 0;                  //!< Counter used to stamp cache lines
+
+    /**
+     * @brief Resets the controller and sends the initialization sequence
+     *
+     * @param[in] pin_res GPIO pin number connected to the reset (RES) pin
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int m_init(const int pin_res);
+
+    /**
+     * @brief Sets the gdram window used by subsequent data reads and writes
+     *
+     * @param[in] column_start First column of the window
+     * @param[in] column_end Last column of the window (inclusive)
+     * @param[in] page_start First page of the window
+     * @param[in] page_end Last page of the window (inclusive)
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int m_window_set(const uint8_t column_start, const uint8_t column_end, const uint8_t page_start, const uint8_t page_end);
+
+    /**
+     * @brief Returns the cache line holding the given gdram byte
+     *
+     * On a miss, the least recently used line is written back if needed,
+     * then refilled by reading the gdram.
+     *
+     * @param[in] column Gdram column of the byte
+     * @param[in] page Gdram page of the byte
+     * @param[out] line Output parameter for the cache line
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int m_cache_fetch(const size_t column, const size_t page, struct cache_line*& line);
+
+    /**
+     * @brief Writes back a cache line to the gdram if it has been modified
+     *
+     * @param[in] line Cache line to write back
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int m_cache_line_flush(struct cache_line& line);
+
+    /**
+     * @brief Writes back all the modified cache lines to the gdram
+     *
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int m_cache_flush(void);
+
+    /**
+     * @brief Flushes the display if a refresh is pending and allowed
+     *
+     * @param[in] now Current time in milliseconds
+     * @return 0 on success, or a negative error code otherwise
+     */
+    int m_refresh_handle(const uint32_t now);
+
     /**
      * @brief Handles coordinate rotation and validation
      *